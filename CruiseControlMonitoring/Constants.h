@@ -26,6 +26,22 @@ static const float SETTLING_TIME_THRESHOLD = 15;		    // XX second settling time
 static const float RAW_ERROR_THRESHOLD = .1; // 0.07;		// XX% max deviation from setpoint 
 															// Good range seems to be 5-15%
 
+// Hill Oscillation Analysis (Goertzel bank over PV - SP)
+static const float OSCILLATION_MAX_FREQUENCY = 0.5;		// Hz; upper end of probed band, bins are 1 / window length apart
+static const int OSCILLATION_MIN_SAMPLES = 20;			// Shorter hill windows are not analyzed
+static const float OSCILLATION_NOISE_SIGMAS = 3;		// Crossing band in standard deviations of the smoothed measurement noise
+static const int OSCILLATION_MIN_PEAKS = 3;				// Half-cycle peaks needed to fit a decay rate
+static const int GOERTZEL_BLOCK = 8;					// Bins per vectorized block; the bank is padded to a multiple of this
+
+// Quantile Sketches
+static const int QUANTILE_SKETCH_K = 200;	// Top compactor capacity; rank error ~1.7 / k, memory ~3k floats per sketch
+
+// Elevation Classes
+static const int ELEVATION_FLAT = 0;
+static const int ELEVATION_RISING = 1;
+static const int ELEVATION_FALLING = 2;
+static const int NUM_ELEVATION_CLASSES = 3;
+
 // Enumerated Names
 static const int RISE_TIME = 0;
 static const int SETTLING_TIME = 1;
@@ -5,6 +5,8 @@
 #include <iomanip>
 #include <string>
 #include <vector>
+#include <cmath>
+#include <algorithm>
 using namespace std;
 
 //////////////////////////////////
@@ -28,8 +30,10 @@ CruiseControllerMonitor::CruiseControllerMonitor(string filePath)
 	calcHillOsccilationIntervals();
 	calculateRiseTimes();
 	calculateSettlingTimesOfHills();
+	calculateHillOscillations();
 	calculateRawError();
 	calcErrorBreakDown();
+	calculateErrorSketches();
 }
 
 // Destructor
@@ -232,6 +236,9 @@ void CruiseControllerMonitor::triggerFault(int start, int end, int key)
 // percentage of the steady-state value (commonly  +-2% or +-5% of the steady-state value)
 void CruiseControllerMonitor::calculateSettlingTimesOfHills()
 {
+	if (m_hillIndices.empty())
+		return;
+
 	// Error bar limits
 	// Assuming setpoint is constant during hills
 	float setpoint = m_setpoint[m_hillIndices[0][0]];
@@ -282,6 +289,207 @@ void CruiseControllerMonitor::calculateSettlingTimesOfHills()
 	}
 }
 
+// Advances every Goertzel bin by one sample
+// Restrict pointers rule out aliasing and the fixed-size inner loop needs no scalar remainder, so
+// the bank vectorizes at -O2 (bins must be padded to a multiple of GOERTZEL_BLOCK)
+static void goertzelStep(float x, const float* __restrict coeffs, float* __restrict s1, float* __restrict s2, int bins)
+{
+	for (int block = 0; block < bins; block += GOERTZEL_BLOCK)
+	{
+		for (int b = block; b < block + GOERTZEL_BLOCK; b++)
+		{
+			float s0 = x + coeffs[b] * s1[b] - s2[b];
+			s2[b] = s1[b];
+			s1[b] = s0;
+		}
+	}
+}
+
+// Characterizes the velocity oscillation of each hill window from the error signal PV - SP
+// Dominant Frequency: strongest bin of a Goertzel bank over [1 / window length, OSCILLATION_MAX_FREQUENCY]
+// Decay Rate: -slope of ln(half-cycle peak) over time (exponential envelope e^(-sigma * t))
+// Damping Ratio: sigma / sqrt(sigma^2 + (2 * pi * f)^2)
+// Peak Amplitude: max |PV - SP| within the window
+void CruiseControllerMonitor::calculateHillOscillations()
+{
+	const float PI = 3.14159265f;
+	// Scratch buffers reused for every hill window
+	vector<float> error;
+	vector<float> frequencies;
+	vector<float> coeffs;
+	vector<float> s1;
+	vector<float> s2;
+	vector<float> magnitudes;
+	vector<float> smoothed;
+	vector<float> secondDifferences;
+	vector<float> peakTimes;
+	vector<float> peakLogs;
+
+	for (int i = 0; i < m_hillIndices.size(); i++)
+	{
+		int start = m_hillIndices[i][0];
+		int end = min(int(m_hillIndices[i][1]) + 1, m_lines);
+		int n = end - start;
+
+		// Error signal with its mean removed so the DC offset doesn't swamp the lowest bins
+		error.resize(n);
+		float mean = 0;
+		float peakAmplitude = 0;
+		for (int k = 0; k < n; k++)
+		{
+			error[k] = m_measurement[start + k] - m_setpoint[start + k];
+			mean += error[k];
+			peakAmplitude = max(peakAmplitude, float(fabs(error[k])));
+		}
+
+		// Too short for frequency and decay analysis; peak amplitude is still valid
+		if (n < OSCILLATION_MIN_SAMPLES)
+		{
+			m_hillOscillations.push_back({ m_hillIndices[i][0], m_hillIndices[i][1], INFINITY_S, INFINITY_S, INFINITY_S, peakAmplitude });
+			continue;
+		}
+		mean /= n;
+		for (int k = 0; k < n; k++)
+			error[k] -= mean;
+
+		// Goertzel bank: all bins advance together per sample
+		// Bins sit at multiples of the window's resolution 1 / T, up to OSCILLATION_MAX_FREQUENCY
+		float resolution = 1 / (n * STEP_INTERVAL);
+		int bins = max(1, int(OSCILLATION_MAX_FREQUENCY / resolution));
+		// Padding bins past the band keep coefficient 0 and are never read back
+		int paddedBins = (bins + GOERTZEL_BLOCK - 1) / GOERTZEL_BLOCK * GOERTZEL_BLOCK;
+		frequencies.resize(bins);
+		magnitudes.resize(bins);
+		coeffs.assign(paddedBins, 0);
+		s1.assign(paddedBins, 0);
+		s2.assign(paddedBins, 0);
+		for (int b = 0; b < bins; b++)
+		{
+			frequencies[b] = (b + 1) * resolution;
+			coeffs[b] = 2 * cos(2 * PI * frequencies[b] * STEP_INTERVAL);
+		}
+		for (int k = 0; k < n; k++)
+			goertzelStep(error[k], coeffs.data(), s1.data(), s2.data(), paddedBins);
+		int bestBin = 0;
+		for (int b = 0; b < bins; b++)
+		{
+			float power = s1[b] * s1[b] + s2[b] * s2[b] - coeffs[b] * s1[b] * s2[b];
+			magnitudes[b] = sqrt(max(power, 0.0f));
+			if (magnitudes[b] > magnitudes[bestBin])
+				bestBin = b;
+		}
+		// Parabolic interpolation between the strongest bin and its neighbours
+		float dominantFrequency = frequencies[bestBin];
+		if (bestBin > 0 && bestBin < bins - 1)
+		{
+			float left = magnitudes[bestBin - 1];
+			float center = magnitudes[bestBin];
+			float right = magnitudes[bestBin + 1];
+			float denominator = left - 2 * center + right;
+			if (denominator != 0)
+			{
+				float offset = 0.5f * (left - right) / denominator;
+				dominantFrequency += max(-0.5f, min(0.5f, offset)) * resolution;
+			}
+		}
+
+		// Half-cycle peaks: largest |error| between consecutive zero crossings
+		// Noise is rejected before crossings are counted:
+		//  - the error is smoothed with a moving average about a quarter period long (scales every peak
+		//    by the same factor, so the decay slope is unaffected)
+		//  - the sign only flips once the smoothed error leaves a hysteresis band a few noise standard
+		//    deviations wide; the band doubles as a noise floor since every half-cycle must exceed it
+		//  - a flip is only accepted a quarter period after the previous one
+		// Partial half-cycles at either end of the window are skipped
+		int minSpacing = max(1, int(1 / (4 * dominantFrequency * STEP_INTERVAL)));
+		int halfWidth = minSpacing / 2;
+		smoothed.resize(n);
+		float runningSum = 0;
+		int lo = 0;
+		int hi = -1;
+		for (int k = 0; k < n; k++)
+		{
+			int newLo = max(0, k - halfWidth);
+			int newHi = min(n - 1, k + halfWidth);
+			while (hi < newHi)
+				runningSum += error[++hi];
+			while (lo < newLo)
+				runningSum -= error[lo++];
+			smoothed[k] = runningSum / (hi - lo + 1);
+		}
+
+		// Noise standard deviation from the median second difference (variance 6 sigma^2 for white noise;
+		// a slow oscillation barely contributes)
+		secondDifferences.clear();
+		for (int k = 1; k < n - 1; k++)
+			secondDifferences.push_back(fabs(error[k + 1] - 2 * error[k] + error[k - 1]));
+		nth_element(secondDifferences.begin(), secondDifferences.begin() + secondDifferences.size() / 2, secondDifferences.end());
+		float noiseSigma = secondDifferences[secondDifferences.size() / 2] / (0.6745f * sqrt(6.0f));
+		float band = OSCILLATION_NOISE_SIGMAS * noiseSigma / sqrt(float(2 * halfWidth + 1));
+
+		peakTimes.clear();
+		peakLogs.clear();
+		int sign = 0;				// Sign of the current half-cycle, 0 until the band is first left
+		int peakIndex = 0;
+		int lastCrossing = -1;		// Sample of the last accepted crossing, -1 before the first
+		for (int k = 0; k < n; k++)
+		{
+			int newSign = 0;
+			if (smoothed[k] > band)
+				newSign = 1;
+			else if (smoothed[k] < -band)
+				newSign = -1;
+
+			if (newSign != 0 && newSign != sign && (sign == 0 || k - lastCrossing >= minSpacing))
+			{
+				// Close the previous half-cycle if it was bounded by a crossing on both sides
+				if (sign != 0 && lastCrossing >= 0)
+				{
+					peakTimes.push_back(m_time[start + peakIndex]);
+					peakLogs.push_back(log(fabs(smoothed[peakIndex])));
+				}
+				if (sign != 0)
+					lastCrossing = k;
+				sign = newSign;
+				peakIndex = k;
+			}
+			if (sign != 0 && smoothed[k] * sign > smoothed[peakIndex] * sign)
+				peakIndex = k;
+		}
+
+		// Least-squares slope of ln(peak) vs time
+		float decayRate = INFINITY_S;
+		if (peakTimes.size() >= OSCILLATION_MIN_PEAKS)
+		{
+			float meanT = 0;
+			float meanL = 0;
+			for (int k = 0; k < peakTimes.size(); k++)
+			{
+				meanT += peakTimes[k];
+				meanL += peakLogs[k];
+			}
+			meanT /= peakTimes.size();
+			meanL /= peakTimes.size();
+			float covariance = 0;
+			float variance = 0;
+			for (int k = 0; k < peakTimes.size(); k++)
+			{
+				covariance += (peakTimes[k] - meanT) * (peakLogs[k] - meanL);
+				variance += (peakTimes[k] - meanT) * (peakTimes[k] - meanT);
+			}
+			if (variance > 0)
+				decayRate = -covariance / variance;
+		}
+
+		float dampingRatio = INFINITY_S;
+		if (decayRate != INFINITY_S)
+		{
+			float omega = 2 * PI * dominantFrequency;
+			dampingRatio = decayRate / sqrt(decayRate * decayRate + omega * omega);
+		}
+		m_hillOscillations.push_back({ m_hillIndices[i][0], m_hillIndices[i][1], dominantFrequency, decayRate, dampingRatio, peakAmplitude });
+	}
+}
 
 // Calculates the relative rise time for transient periods and average steady state error if it exists
 // Rise Time: the amount of time the system takes to go from 10% to 90% of the target steady-state value.*
@@ -365,8 +573,9 @@ void CruiseControllerMonitor::calcHillOsccilationIntervals()
 			float t2 = m_time[m_elevationChangeIndices[j][1]];
 			float min = m_time[m_steadyState[i][0]];
 			float max = m_time[m_steadyState[i][1]];
-			// If elevation change is within steady state period
-			if (t1 >= min)
+			// If elevation change starts within steady state period (later intervals would give
+			// inverted windows clipped to this period's end)
+			if (t1 >= min && t1 < max)
 			{
 				// If elevation interval runs past current steady state period, set it to the upper limit 
 				// of the period
@@ -407,6 +616,101 @@ void CruiseControllerMonitor::calcErrorBreakDown()
 	m_riseTimeFraction = float(m_riseTimeFaults) / NUM_DATA_SAMPLES;
 }
 
+// Elevation class of an interval in m_elevationChangeIndices, from its dominant slope
+// Total climb vs total descent, so a crest or dip (net change ~0) isn't classed as flat; ties go to rising
+int CruiseControllerMonitor::elevationClassOf(int intervalIndex)
+{
+	float climb = 0;
+	float descent = 0;
+	for (int k = m_elevationChangeIndices[intervalIndex][0]; k < m_elevationChangeIndices[intervalIndex][1]; k++)
+	{
+		float change = m_elevation[k + 1] - m_elevation[k];
+		if (change > 0)
+			climb += change;
+		else
+			descent -= change;
+	}
+	if (climb == 0 && descent == 0)
+		return ELEVATION_FLAT;
+	if (climb >= descent)
+		return ELEVATION_RISING;
+	return ELEVATION_FALLING;
+}
+
+// Elevation class of the interval containing a data index (intervals share end points, first match wins)
+int CruiseControllerMonitor::elevationClassAt(int dataIndex)
+{
+	for (int j = 0; j < m_elevationChangeIndices.size(); j++)
+	{
+		if (dataIndex >= m_elevationChangeIndices[j][0] && dataIndex < m_elevationChangeIndices[j][1])
+			return elevationClassOf(j);
+	}
+	return elevationClassOf(m_elevationChangeIndices.size() - 1);
+}
+
+// Streams raw error, settling times and rise times into quantile sketches per steady-state period,
+// per trace and per elevation class
+// Sketches use bounded memory and can be merged across files/threads for fleet-wide percentiles
+void CruiseControllerMonitor::calculateErrorSketches()
+{
+	// Raw error
+	for (int i = 0; i < m_rawError.size(); i++)
+		m_traceSketches.rawError.add(m_rawError[i]);
+	m_steadyStateSketches.resize(m_steadyState.size());
+	for (int i = 0; i < m_steadyState.size(); i++)
+	{
+		for (int k = m_steadyState[i][0]; k < m_steadyState[i][1] + 1 && k < m_rawError.size(); k++)
+			m_steadyStateSketches[i].rawError.add(m_rawError[k]);
+	}
+	// Each sample is classed by its own step slope, so both halves of a crest or dip are filed correctly
+	// (interval classes are only used for settling and rise times below)
+	for (int k = 0; k < m_rawError.size() && k < m_lines; k++)
+	{
+		// The last sample takes the slope of the step leading into it
+		float change = 0;
+		if (k + 1 < m_lines)
+			change = m_elevation[k + 1] - m_elevation[k];
+		else if (k > 0)
+			change = m_elevation[k] - m_elevation[k - 1];
+		int elevationClass = ELEVATION_FLAT;
+		if (change > 0)
+			elevationClass = ELEVATION_RISING;
+		else if (change < 0)
+			elevationClass = ELEVATION_FALLING;
+		m_elevationSketches[elevationClass].rawError.add(m_rawError[k]);
+	}
+
+	// Settling times (infinite settling times are already counted as faults)
+	for (int i = 0; i < m_hillIndices.size(); i++)
+	{
+		float settlingTime = m_hillIndices[i][2];
+		if (settlingTime == INFINITY_S)
+			continue;
+		int start = m_hillIndices[i][0];
+		m_traceSketches.settlingTime.add(settlingTime);
+		m_elevationSketches[elevationClassAt(start)].settlingTime.add(settlingTime);
+		for (int k = 0; k < m_steadyState.size(); k++)
+		{
+			if (start >= m_steadyState[k][0] && start <= m_steadyState[k][1])
+			{
+				m_steadyStateSketches[k].settlingTime.add(settlingTime);
+				break;
+			}
+		}
+	}
+
+	// Rise times (transient i leads into steady-state period i)
+	for (int i = 0; i < m_steadyState.size() && i < m_transient.size(); i++)
+	{
+		if (m_transient[i].size() < 4 || m_transient[i][3] == INFINITY_S)
+			continue;
+		float riseTime = m_transient[i][3];
+		m_traceSketches.riseTime.add(riseTime);
+		m_steadyStateSketches[i].riseTime.add(riseTime);
+		m_elevationSketches[elevationClassAt(m_transient[i][0])].riseTime.add(riseTime);
+	}
+}
+
 
 ////////////////////////////
 // UNFINISHED DEVELOPMENT //
@@ -487,6 +791,27 @@ void CruiseControllerMonitor::printHillTimeImpacts()
 	cout << endl;
 }
 
+void CruiseControllerMonitor::printHillOscillations()
+{
+	cout << "Oscillation Characteristics of Elevation-Induced Velocity Disturbances: " << endl;
+	cout << "Elevation Time Interval [s,s] : Dominant frequency [Hz] : Decay rate [1/s] : Damping ratio : Peak amplitude [m/s]" << endl;
+	static const string units[4] = { " Hz", " 1/s", "", " m/s" };
+	for (int i = 0; i < m_hillOscillations.size(); i++)
+	{
+		cout << "[" << m_time[m_hillOscillations[i][0]] << "s, " << m_time[m_hillOscillations[i][1]] << "s]";
+		for (int k = 0; k < 4; k++)
+		{
+			cout << " : ";
+			if (m_hillOscillations[i][k + 2] == INFINITY_S)
+				cout << "N/A";
+			else
+				cout << m_hillOscillations[i][k + 2] << units[k];
+		}
+		cout << endl;
+	}
+	cout << endl;
+}
+
 // Prints pre-processed data
 void CruiseControllerMonitor::printAllData()
 {
@@ -524,4 +849,68 @@ void CruiseControllerMonitor::printErrorBreakDown()
 	cout << "Percent error due to settling time: " << m_settlingTimeFraction * 100 << "%" << endl;
 	cout << "Percent error due to rise time: " << m_riseTimeFraction * 100 << "%" << endl;
 	cout << endl;
+}
+
+void CruiseControllerMonitor::printSketchQuantiles(string label, const QuantileSketch& sketch, string unit)
+{
+	cout << label << ": ";
+	if (sketch.empty())
+	{
+		cout << "no samples" << endl;
+		return;
+	}
+	// Both tails: raw error is signed (SP - PV), so overspeed shows up in the low percentiles
+	cout << "min " << sketch.getMin() << unit << ", p1 " << sketch.quantile(0.01) << unit
+		<< ", p10 " << sketch.quantile(0.1) << unit << ", p50 " << sketch.quantile(0.5) << unit
+		<< ", p90 " << sketch.quantile(0.9) << unit << ", p99 " << sketch.quantile(0.99) << unit
+		<< ", max " << sketch.getMax() << unit << " (" << sketch.getCount() << " samples)" << endl;
+}
+
+void CruiseControllerMonitor::printErrorQuantiles()
+{
+	static const string elevationNames[NUM_ELEVATION_CLASSES] = { "Flat", "Rising", "Falling" };
+
+	cout << "Error Distributions: " << endl;
+	printSketchQuantiles("Raw error", m_traceSketches.rawError, " m/s");
+	printSketchQuantiles("Settling time", m_traceSketches.settlingTime, "s");
+	printSketchQuantiles("Rise time", m_traceSketches.riseTime, "s");
+	cout << endl;
+
+	for (int c = 0; c < NUM_ELEVATION_CLASSES; c++)
+	{
+		cout << elevationNames[c] << " elevation:" << endl;
+		printSketchQuantiles("Raw error", m_elevationSketches[c].rawError, " m/s");
+		printSketchQuantiles("Settling time", m_elevationSketches[c].settlingTime, "s");
+		printSketchQuantiles("Rise time", m_elevationSketches[c].riseTime, "s");
+	}
+	cout << endl;
+
+	cout << "Steady-state Raw Error Distributions: " << endl;
+	for (int i = 0; i < m_steadyStateSketches.size(); i++)
+	{
+		stringstream interval;
+		interval << "[" << m_time[m_steadyState[i][0]] << "s, " << m_time[m_steadyState[i][1]] << "s]";
+		printSketchQuantiles(interval.str(), m_steadyStateSketches[i].rawError, " m/s");
+	}
+	cout << endl;
+}
+
+const ErrorSketches& CruiseControllerMonitor::getTraceSketches() const
+{
+	return m_traceSketches;
+}
+
+const vector<ErrorSketches>& CruiseControllerMonitor::getSteadyStateSketches() const
+{
+	return m_steadyStateSketches;
+}
+
+const ErrorSketches& CruiseControllerMonitor::getElevationSketches(int elevationClass) const
+{
+	return m_elevationSketches[elevationClass];
+}
+
+const vector<vector<float>>& CruiseControllerMonitor::getHillOscillations() const
+{
+	return m_hillOscillations;
 }
\ No newline at end of file
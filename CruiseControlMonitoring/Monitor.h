@@ -1,5 +1,6 @@
 #pragma once
 #include "Constants.h"
+#include "QuantileSketch.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -30,9 +31,25 @@ class CruiseControllerMonitor
 		// Periods of flat, increasing, and decreasing elevation
 		void printElevationTimeIntervals();
 		void printHillTimeImpacts();
+		void printHillOscillations();
 		void printConstants();
 		int getNumFaults();
 		void printErrorBreakDown();
+		// Percentiles of raw error, settling time and rise time
+		void printErrorQuantiles();
+
+		///////////////////////
+		// Quantile Sketches //
+		///////////////////////
+
+		// Merge these across monitors (files or threads) for fleet-wide percentiles
+		const ErrorSketches& getTraceSketches() const;
+		const std::vector<ErrorSketches>& getSteadyStateSketches() const;
+		const ErrorSketches& getElevationSketches(int elevationClass) const;
+
+		// Oscillation characteristics of each hill window, to collect across files/threads
+		// Index Key: see m_hillOscillations
+		const std::vector<std::vector<float>>& getHillOscillations() const;
 
 	private:
 
@@ -70,6 +87,10 @@ class CruiseControllerMonitor
 		// Indices of oscillations caused by hills
 		// Index Key: [dataIndex1, dataIndex2, settlingTime from dataIndex1]
 		std::vector<std::vector<float>> m_hillIndices;																
+
+		// Oscillation characteristics of each hill window, INFINITY_S where not analyzed
+		// Index Key: [dataIndex1, dataIndex2, dominantFrequency, decayRate, dampingRatio, peakAmplitude]
+		std::vector<std::vector<float>> m_hillOscillations;
 																						
 		// Indices of significant elevation periods
 		// Index Key: [dataIndex1, dataIndex2]
@@ -91,13 +112,22 @@ class CruiseControllerMonitor
 		float m_rawErrorFraction;
 		float m_riseTimeFraction;
 		float m_settlingTimeFraction;
+
+		// Error distributions
+		ErrorSketches m_traceSketches;
+		// Index Key: same as m_steadyState
+		std::vector<ErrorSketches> m_steadyStateSketches;
+		// Index Key: [ELEVATION_FLAT, ELEVATION_RISING, ELEVATION_FALLING]
+		ErrorSketches m_elevationSketches[NUM_ELEVATION_CLASSES];
 	
 		//////////////////////////
 		// Performance Analysis //
 		//////////////////////////
 		void calculateSettlingTimesOfHills();
+		void calculateHillOscillations();
 		void calculateRiseTimes();
 		void calculateRawError();
+		void calculateErrorSketches();
 
 		//////////////////////
 		// Helper Functions //
@@ -109,6 +139,9 @@ class CruiseControllerMonitor
 		void calcHillOsccilationIntervals();
 		void triggerFault(int start, int end, int key);
 		void calcErrorBreakDown();
+		int elevationClassOf(int intervalIndex);
+		int elevationClassAt(int dataIndex);
+		void printSketchQuantiles(std::string label, const QuantileSketch& sketch, std::string unit);
 
 		// void maxUnderOverGivenTimeIndexandSetpoint(int a, int b, float setpoint);	// Not implemented
 
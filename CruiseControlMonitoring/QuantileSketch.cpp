@@ -0,0 +1,177 @@
+#include "QuantileSketch.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+using namespace std;
+
+//////////////////////////////////////////
+// Quantile Sketch Class Implementation //
+//////////////////////////////////////////
+
+// Constructor
+QuantileSketch::QuantileSketch(int k)
+	: m_k(k), m_count(0), m_size(0), m_maxSize(0), m_min(0), m_max(0)
+{
+	grow();
+}
+
+// Capacity shrinks geometrically (by 2/3) from the top level down, but never below 2
+int QuantileSketch::capacity(int level) const
+{
+	int depth = m_compactors.size() - 1 - level;
+	return std::max(2, int(ceil(m_k * pow(2.0 / 3.0, depth))));
+}
+
+// Adds a new top level and recomputes the total capacity
+void QuantileSketch::grow()
+{
+	m_compactors.push_back(vector<float>());
+	m_offsets.push_back(false);
+	m_maxSize = 0;
+	for (int h = 0; h < m_compactors.size(); h++)
+		m_maxSize += capacity(h);
+}
+
+// Compacts the lowest overfull level: sort it and promote every other item one level up
+void QuantileSketch::compress()
+{
+	for (int h = 0; h < m_compactors.size(); h++)
+	{
+		if (m_compactors[h].size() < capacity(h))
+			continue;
+		if (h + 1 >= m_compactors.size())
+			grow();
+
+		vector<float>& items = m_compactors[h];
+		sort(items.begin(), items.end());
+		// An odd item out stays behind so total weight is preserved
+		float leftover = 0;
+		bool hasLeftover = items.size() % 2 == 1;
+		if (hasLeftover)
+		{
+			leftover = items.back();
+			items.pop_back();
+		}
+		int offset = m_offsets[h] ? 1 : 0;
+		m_offsets[h] = !m_offsets[h];
+		for (int i = offset; i < items.size(); i += 2)
+			m_compactors[h + 1].push_back(items[i]);
+		items.clear();
+		if (hasLeftover)
+			items.push_back(leftover);
+		break;
+	}
+
+	m_size = 0;
+	for (int h = 0; h < m_compactors.size(); h++)
+		m_size += m_compactors[h].size();
+}
+
+void QuantileSketch::add(float value)
+{
+	if (m_count == 0)
+	{
+		m_min = value;
+		m_max = value;
+	}
+	m_min = std::min(m_min, value);
+	m_max = std::max(m_max, value);
+	m_count++;
+
+	m_compactors[0].push_back(value);
+	m_size++;
+	if (m_size >= m_maxSize)
+		compress();
+}
+
+bool QuantileSketch::merge(const QuantileSketch& other)
+{
+	// Compactor capacities depend on k, so mixed-k levels can't be combined
+	if (other.m_k != m_k)
+		return false;
+	if (other.m_count == 0)
+		return true;
+	if (m_count == 0)
+	{
+		m_min = other.m_min;
+		m_max = other.m_max;
+	}
+	m_min = std::min(m_min, other.m_min);
+	m_max = std::max(m_max, other.m_max);
+	m_count += other.m_count;
+
+	while (m_compactors.size() < other.m_compactors.size())
+		grow();
+	for (int h = 0; h < other.m_compactors.size(); h++)
+		m_compactors[h].insert(m_compactors[h].end(), other.m_compactors[h].begin(), other.m_compactors[h].end());
+
+	m_size = 0;
+	for (int h = 0; h < m_compactors.size(); h++)
+		m_size += m_compactors[h].size();
+	while (m_size >= m_maxSize)
+		compress();
+	return true;
+}
+
+// Weighted rank lookup over all retained items
+float QuantileSketch::quantile(float q) const
+{
+	if (m_count == 0)
+		return 0;
+	if (q <= 0)
+		return m_min;
+	if (q >= 1)
+		return m_max;
+
+	// [value, weight]
+	vector<pair<float, long long>> weighted;
+	weighted.reserve(m_size);
+	long long totalWeight = 0;
+	for (int h = 0; h < m_compactors.size(); h++)
+	{
+		long long weight = 1LL << h;
+		for (int i = 0; i < m_compactors[h].size(); i++)
+			weighted.push_back({ m_compactors[h][i], weight });
+		totalWeight += weight * m_compactors[h].size();
+	}
+	sort(weighted.begin(), weighted.end());
+
+	double target = q * totalWeight;
+	long long cumulative = 0;
+	for (int i = 0; i < weighted.size(); i++)
+	{
+		cumulative += weighted[i].second;
+		if (cumulative >= target)
+			return weighted[i].first;
+	}
+	return m_max;
+}
+
+long long QuantileSketch::getCount() const
+{
+	return m_count;
+}
+
+float QuantileSketch::getMin() const
+{
+	return m_min;
+}
+
+float QuantileSketch::getMax() const
+{
+	return m_max;
+}
+
+bool QuantileSketch::empty() const
+{
+	return m_count == 0;
+}
+
+bool ErrorSketches::merge(const ErrorSketches& other)
+{
+	bool merged = rawError.merge(other.rawError);
+	merged = settlingTime.merge(other.settlingTime) && merged;
+	merged = riseTime.merge(other.riseTime) && merged;
+	return merged;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "Constants.h"
+#include <vector>
+
+///////////////////////////
+// Quantile Sketch Class //
+///////////////////////////
+
+// Mergeable streaming quantile sketch (KLL)
+// Keeps a stack of compactors; level h holds items of weight 2^h. When the sketch is full, the
+// lowest overfull level is sorted and every other item is promoted to the next level.
+// Memory stays bounded at roughly 3k items no matter how many samples are added, and two
+// sketches (e.g. from different files or threads) can be merged level by level.
+class QuantileSketch
+{
+	public:
+		explicit QuantileSketch(int k = QUANTILE_SKETCH_K);
+
+		// Adds a single sample
+		void add(float value);
+		// Folds another sketch into this one (the other sketch is left unchanged)
+		// Returns false and does nothing if the sketches were built with different k
+		bool merge(const QuantileSketch& other);
+
+		// Estimated value at quantile q [0, 1]; returns 0 for an empty sketch
+		float quantile(float q) const;
+		long long getCount() const;
+		float getMin() const;
+		float getMax() const;
+		bool empty() const;
+
+	private:
+		int m_k;						// Accuracy parameter (top compactor capacity)
+		long long m_count;				// Samples seen, including merged sketches
+		int m_size;						// Items currently held across all compactors
+		int m_maxSize;					// Sum of compactor capacities
+		float m_min;
+		float m_max;
+
+		// Index Key: [level][item], items at level h have weight 2^h
+		std::vector<std::vector<float>> m_compactors;
+		// Alternating compaction offset per level (deterministic replacement for a coin flip)
+		std::vector<bool> m_offsets;
+
+		int capacity(int level) const;
+		void grow();
+		void compress();
+};
+
+// Raw error, settling time and rise time sketches for one grouping of samples
+struct ErrorSketches
+{
+	QuantileSketch rawError;		// [m/s]
+	QuantileSketch settlingTime;	// [s]
+	QuantileSketch riseTime;		// [s]
+
+	// Returns false if any sketch pair has mismatched k (matching pairs are still merged)
+	bool merge(const ErrorSketches& other);
+};
@@ -12,11 +12,13 @@ int main()
 	monitor.printConstants();
 	int numFaults = monitor.getNumFaults(); // Returns if you want to further manipulate numFaults
 	monitor.printErrorBreakDown();
+	monitor.printErrorQuantiles();
 
 	// Details
 	monitor.printTransientPeriods();
 	monitor.printSteadyStatePeriods();
 	monitor.printHillTimeImpacts();
+	monitor.printHillOscillations();
 	monitor.printElevationTimeIntervals();
 	monitor.writeToControllerData();
 }